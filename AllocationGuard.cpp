@@ -0,0 +1,106 @@
+#include "AllocationGuard.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <tuple>
+
+#include <unistd.h>
+
+namespace
+{
+thread_local bool allocationsForbidden = false;
+
+#ifndef NDEBUG
+[[noreturn]] void allocationViolation(const char *what)
+{
+    // No stdio here: it may allocate, and we are already inside operator new/delete
+    static const char prefix[] = "AllocationGuard: ";
+    static const char suffix[] = " on a real-time thread\n";
+    std::ignore = write(STDERR_FILENO, prefix, sizeof(prefix) - 1);
+    std::ignore = write(STDERR_FILENO, what, strlen(what));
+    std::ignore = write(STDERR_FILENO, suffix, sizeof(suffix) - 1);
+    abort();
+}
+
+void *guardedAlloc(size_t size, size_t alignment)
+{
+    if (allocationsForbidden) {
+        allocationViolation("heap allocation");
+    }
+    if (size == 0) {
+        size = 1;
+    }
+    void *ptr = nullptr;
+    if (alignment <= alignof(std::max_align_t)) {
+        ptr = malloc(size);
+    }
+    else if (posix_memalign(&ptr, alignment, size) != 0) {
+        ptr = nullptr;
+    }
+    return ptr;
+}
+
+void guardedFree(void *ptr)
+{
+    if (ptr != nullptr && allocationsForbidden) {
+        allocationViolation("heap deallocation");
+    }
+    free(ptr);
+}
+#endif
+}// namespace
+
+#ifndef NDEBUG
+void *operator new(size_t size)
+{
+    if (auto *ptr = guardedAlloc(size, alignof(std::max_align_t))) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return guardedAlloc(size, alignof(std::max_align_t)); }
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return guardedAlloc(size, alignof(std::max_align_t)); }
+
+void *operator new(size_t size, std::align_val_t alignment)
+{
+    if (auto *ptr = guardedAlloc(size, static_cast<size_t>(alignment))) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+
+void operator delete(void *ptr) noexcept { guardedFree(ptr); }
+void operator delete[](void *ptr) noexcept { guardedFree(ptr); }
+void operator delete(void *ptr, size_t) noexcept { guardedFree(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { guardedFree(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { guardedFree(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { guardedFree(ptr); }
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept { guardedFree(ptr); }
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept { guardedFree(ptr); }
+#endif
+
+AllocationGuard::AllocationGuard()
+    : _wasArmed(allocationsForbidden)
+{
+#ifndef NDEBUG
+    allocationsForbidden = true;
+#endif
+}
+
+AllocationGuard::~AllocationGuard()
+{
+    allocationsForbidden = _wasArmed;
+}
+
+bool AllocationGuard::isArmed()
+{
+    return allocationsForbidden;
+}
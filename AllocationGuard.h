@@ -0,0 +1,27 @@
+#ifndef ALLOCATION_GUARD_H
+#define ALLOCATION_GUARD_H
+
+/**
+ * Scoped guard that aborts on any operator new/delete from the owning thread.
+ *
+ * Only enforced in builds without NDEBUG; in release builds it compiles to nothing.
+ * Allocations that bypass operator new (plain malloc) are not caught.
+ * The replacement operators live in AllocationGuard.cpp, so only binaries
+ * that link it get them.
+ */
+class AllocationGuard
+{
+public:
+    AllocationGuard();
+    ~AllocationGuard();
+
+    AllocationGuard(const AllocationGuard &) = delete;
+    AllocationGuard &operator=(const AllocationGuard &) = delete;
+
+    [[nodiscard]] static bool isArmed();
+
+private:
+    bool _wasArmed{false};
+};
+
+#endif// ALLOCATION_GUARD_H
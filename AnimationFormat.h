@@ -0,0 +1,50 @@
+#ifndef ANIMATION_FORMAT_H
+#define ANIMATION_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Precompiled animation file, produced by tools/anim_compile and played by AnimationPlayer.
+ *
+ * Layout (native little-endian):
+ *   AnimationHeader
+ *   AnimationChip[chipCount]
+ *   padding up to dataOffset
+ *   frameCount frames of frameSize bytes, one per tick
+ *
+ * A frame holds one ready-to-send register burst per chip at AnimationChip::burstOffset:
+ * the LEDn_ON_L start register followed by ON_L, ON_H, OFF_L, OFF_H for each channel.
+ */
+struct AnimationHeader
+{
+    static constexpr char kMagic[4] = {'P', 'C', 'A', 'A'};
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kDataAlignment = 64;
+
+    char magic[4];
+    uint32_t version;
+    uint32_t tickNs;      //! Period between frames
+    uint32_t frameCount;
+    uint32_t frameSize;   //! Bytes per frame, all chip bursts back to back
+    uint32_t chipCount;
+    uint32_t dataOffset;  //! File offset of the first frame
+    float pwmFrequency;   //! Chips are set to this frequency before playback
+};
+
+struct AnimationChip
+{
+    // pca9685 hardware addresses, without the reserved 0x78..0x7F
+    static constexpr int32_t kFirstAddress = 0x40;
+    static constexpr int32_t kLastAddress = 0x77;
+
+    uint32_t busNumber;
+    int32_t address;
+    uint32_t burstOffset; //! Offset of this chip's burst inside a frame
+    uint32_t burstSize;   //! Start register + 4 bytes per channel
+};
+
+static_assert(sizeof(AnimationHeader) == 32, "AnimationHeader layout is part of the file format");
+static_assert(sizeof(AnimationChip) == 16, "AnimationChip layout is part of the file format");
+
+#endif // ANIMATION_FORMAT_H
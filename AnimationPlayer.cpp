@@ -0,0 +1,188 @@
+#include "AnimationPlayer.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "I2CPwmMultiplexer.h"
+#include "PwmPacker.h"
+#include "RealTime.h"
+
+namespace
+{
+bool isBurstValid(const std::byte *burst, uint32_t size)
+{
+    if (size < 1 + PwmPacker::kBytesPerChannel || (size - 1) % PwmPacker::kBytesPerChannel != 0) {
+        return false;
+    }
+    const auto startReg = std::to_integer<uint32_t>(burst[0]);
+    if (startReg < PwmPacker::kLed0OnL || (startReg - PwmPacker::kLed0OnL) % PwmPacker::kBytesPerChannel != 0) {
+        return false;
+    }
+    const auto firstChannel = (startReg - PwmPacker::kLed0OnL) / PwmPacker::kBytesPerChannel;
+    const auto channelCount = (size - 1) / PwmPacker::kBytesPerChannel;
+    return firstChannel + channelCount <= I2CPwmMultiplexer::kChannelCount;
+}
+}// namespace
+
+AnimationPlayer::AnimationPlayer(const std::string &path)
+{
+    const int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        fprintf(stderr, "Failed to open animation %s. Error message: %s\n", path.c_str(), strerror(errno));
+        return;
+    }
+
+    struct stat info{};
+    if (fstat(descriptor, &info) == 0 && info.st_size > 0) {
+        _mapSize = static_cast<size_t>(info.st_size);
+        // Populate up front so the first frames do not page fault
+        void *map = mmap(nullptr, _mapSize, PROT_READ, MAP_PRIVATE | MAP_POPULATE, descriptor, 0);
+        if (map != MAP_FAILED) {
+            _map = static_cast<const std::byte *>(map);
+            madvise(map, _mapSize, MADV_SEQUENTIAL);
+        }
+        else {
+            fprintf(stderr, "Failed to map animation %s. Error message: %s\n", path.c_str(), strerror(errno));
+            _mapSize = 0;
+        }
+    }
+    close(descriptor);
+
+    if (_map == nullptr) {
+        return;
+    }
+
+    _header = reinterpret_cast<const AnimationHeader *>(_map);
+    _chipTable = reinterpret_cast<const AnimationChip *>(_map + sizeof(AnimationHeader));
+    if (!validate()) {
+        fprintf(stderr, "Invalid animation file %s\n", path.c_str());
+        unmap();
+        return;
+    }
+
+    for (uint32_t i = 0; i < _header->chipCount; ++i) {
+        auto chip = std::make_unique<I2CPwmMultiplexer>(_chipTable[i].busNumber, _chipTable[i].address);
+        chip->setPwmFreq(_header->pwmFrequency);
+        _chips.push_back(std::move(chip));
+    }
+}
+
+AnimationPlayer::~AnimationPlayer()
+{
+    unmap();
+}
+
+bool AnimationPlayer::isOpen() const
+{
+    if (_map == nullptr) {
+        return false;
+    }
+    for (const auto &chip : _chips) {
+        if (!chip->isInit()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t AnimationPlayer::frameCount() const
+{
+    return _header != nullptr ? _header->frameCount : 0;
+}
+
+int64_t AnimationPlayer::tickNs() const
+{
+    return _header != nullptr ? _header->tickNs : 0;
+}
+
+std::error_code AnimationPlayer::lastError() const
+{
+    for (const auto &chip : _chips) {
+        if (auto error = chip->lastError()) {
+            return error;
+        }
+    }
+    return {};
+}
+
+AnimationPlayer::Stats AnimationPlayer::play(const std::atomic<bool> *stop)
+{
+    Stats stats;
+    if (_map == nullptr) {
+        return stats;
+    }
+
+    const auto *frame = _map + _header->dataOffset;
+    auto deadline = RealTime::nowNs();
+    for (uint32_t i = 0; i < _header->frameCount; ++i, frame += _header->frameSize) {
+        if (stop != nullptr && stop->load(std::memory_order_relaxed)) {
+            break;
+        }
+
+        RealTime::sleepUntil(deadline);
+        if (RealTime::nowNs() - deadline > _header->tickNs) {
+            ++stats.lateFrames;
+        }
+
+        for (uint32_t c = 0; c < _header->chipCount; ++c) {
+            if (!_chips[c]->writeBurst(frame + _chipTable[c].burstOffset, _chipTable[c].burstSize)) {
+                ++stats.failedWrites;
+            }
+        }
+        ++stats.framesSent;
+        deadline += _header->tickNs;
+    }
+    return stats;
+}
+
+bool AnimationPlayer::validate() const
+{
+    if (_mapSize < sizeof(AnimationHeader)
+        || memcmp(_header->magic, AnimationHeader::kMagic, sizeof(AnimationHeader::kMagic)) != 0
+        || _header->version != AnimationHeader::kVersion
+        || _header->tickNs == 0 || _header->frameSize == 0 || _header->chipCount == 0
+        || _header->pwmFrequency <= 0.0f) {
+        return false;
+    }
+
+    const auto tableEnd = sizeof(AnimationHeader) + uint64_t(_header->chipCount) * sizeof(AnimationChip);
+    const auto dataEnd = uint64_t(_header->dataOffset) + uint64_t(_header->frameCount) * _header->frameSize;
+    if (tableEnd > _header->dataOffset || dataEnd > _mapSize) {
+        return false;
+    }
+
+    for (uint32_t c = 0; c < _header->chipCount; ++c) {
+        const auto &chip = _chipTable[c];
+        if (chip.address < AnimationChip::kFirstAddress || chip.address > AnimationChip::kLastAddress
+            || uint64_t(chip.burstOffset) + chip.burstSize > _header->frameSize) {
+            return false;
+        }
+    }
+
+    // Every burst is sent as is, so check all of them once here instead of per tick
+    const auto *frame = _map + _header->dataOffset;
+    for (uint32_t i = 0; i < _header->frameCount; ++i, frame += _header->frameSize) {
+        for (uint32_t c = 0; c < _header->chipCount; ++c) {
+            if (!isBurstValid(frame + _chipTable[c].burstOffset, _chipTable[c].burstSize)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void AnimationPlayer::unmap()
+{
+    if (_map != nullptr) {
+        munmap(const_cast<std::byte *>(_map), _mapSize);
+    }
+    _map = nullptr;
+    _mapSize = 0;
+    _header = nullptr;
+    _chipTable = nullptr;
+}
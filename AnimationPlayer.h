@@ -0,0 +1,69 @@
+#ifndef ANIMATION_PLAYER_H
+#define ANIMATION_PLAYER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "AnimationFormat.h"
+
+class I2CPwmMultiplexer;
+
+/**
+ * Plays a precompiled animation file.
+ *
+ * The file is memory-mapped and every frame is sent straight from the mapping,
+ * so playback does no per-frame computation or allocation. Ticks are held with
+ * absolute CLOCK_MONOTONIC deadlines, a late frame does not shift the ones after it.
+ */
+class AnimationPlayer
+{
+public:
+    struct Stats
+    {
+        uint32_t framesSent{0};
+        uint32_t failedWrites{0};
+        uint32_t lateFrames{0}; //! Frames sent more than one tick after their deadline
+    };
+
+    explicit AnimationPlayer(const std::string &path);
+    ~AnimationPlayer();
+
+    // delete copy and move
+    AnimationPlayer(const AnimationPlayer &) = delete;
+    AnimationPlayer(AnimationPlayer &&) = delete;
+    AnimationPlayer &operator=(const AnimationPlayer &) = delete;
+    AnimationPlayer &operator=(AnimationPlayer &&) = delete;
+
+    //! File mapped, valid and every chip bus open
+    [[nodiscard]] bool isOpen() const;
+
+    [[nodiscard]] uint32_t frameCount() const;
+    [[nodiscard]] int64_t tickNs() const;
+
+    //! Last bus error of the first chip that had one, to be reported after playback
+    [[nodiscard]] std::error_code lastError() const;
+
+    /*!
+     *  @brief  Sends every frame at its deadline, starting now
+     *  @param  stop Optional flag checked once per tick to end playback early
+     */
+    Stats play(const std::atomic<bool> *stop = nullptr);
+
+private:
+    [[nodiscard]] bool validate() const;
+    void unmap();
+
+private:
+    const std::byte *_map{nullptr};
+    size_t _mapSize{0};
+    const AnimationHeader *_header{nullptr};
+    const AnimationChip *_chipTable{nullptr};
+    std::vector<std::unique_ptr<I2CPwmMultiplexer>> _chips;
+};
+
+#endif // ANIMATION_PLAYER_H
@@ -1,42 +1,26 @@
 #include "I2CDevImpl.h"
 
+#include <cerrno>
 #include <cstring>
 #include <fcntl.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
 
+#include <map>
 #include <mutex>
 #include <thread>
 
 std::shared_ptr<I2CDeviceImpl> I2CDeviceImpl::Instance(uint32_t busNumber, uint32_t mode) {
     // static variable
     static std::mutex i2cBusMutex;
-    static std::shared_ptr<I2CDeviceImpl> i2cDevice0(nullptr);
-    static std::shared_ptr<I2CDeviceImpl> i2cDevice1(nullptr);
-    static const uint32_t bus0 = 0;
-    static const uint32_t bus1 = 1;
-
-    if (busNumber == bus0) {
-        if (i2cDevice0 == nullptr) {
-            std::lock_guard<std::mutex> lock(i2cBusMutex);
-            if (i2cDevice0 == nullptr) {
-                i2cDevice0 = std::shared_ptr<I2CDeviceImpl>(new I2CDeviceImpl(busNumber, mode));
-            }
-        }
-        return i2cDevice0;
-    }
-    if (busNumber == bus1) {
-        if (i2cDevice1 == nullptr) {
-            std::lock_guard<std::mutex> lock(i2cBusMutex);
-            if (i2cDevice1 == nullptr) {
-                i2cDevice1 = std::shared_ptr<I2CDeviceImpl>(new I2CDeviceImpl(busNumber, mode));
-            }
-        }
-        return i2cDevice1;
-    }
-    fprintf(stderr, "Invalid i2c bus number. Use 1 or 0. Error message: %s", strerror(errno));
+    static std::map<uint32_t, std::shared_ptr<I2CDeviceImpl>> i2cDevices;
 
-    return nullptr;
+    std::lock_guard<std::mutex> lock(i2cBusMutex);
+    auto& i2cDevice = i2cDevices[busNumber];
+    if (i2cDevice == nullptr) {
+        i2cDevice = std::shared_ptr<I2CDeviceImpl>(new I2CDeviceImpl(busNumber, mode));
+    }
+    return i2cDevice;
 }
 
 bool I2CDeviceImpl::IsOpen() const {
@@ -55,7 +39,7 @@ std::pair<int32_t, int32_t> I2CDeviceImpl::WriteRead(std::byte* txBuf,
     return {countTransferred, countReceived};
 }
 
-int32_t I2CDeviceImpl::Write(std::byte* txBuf, size_t bytesToTransfer) const {
+int32_t I2CDeviceImpl::Write(const std::byte* txBuf, size_t bytesToTransfer) const {
     const auto countBytesWrite = write(_descriptor, txBuf, bytesToTransfer);
     if (countBytesWrite != static_cast<int>(bytesToTransfer)) {
         return -1;
@@ -75,37 +59,31 @@ I2CDeviceImpl::~I2CDeviceImpl() {
     Close();
 }
 
+// Runs on every address switch, i.e. on the update path: no formatting or allocation here,
+// failures are kept in LastError() for the caller to report
 const std::error_code& I2CDeviceImpl::SetMode() {
     _errorCode.clear();
 
     if (_address == _kBadDeviceAddress) {
-        _errorCode.assign(errno, std::generic_category());
-        fprintf(stderr,
-                "Failed change mode because. Address is bad. Error message: %s",
-                _errorCode.message().c_str());
-        return _errorCode;
+        _errorCode.assign(EINVAL, std::generic_category());
     }
-
-    if (!IsOpen()) {
-        _errorCode.assign(errno, std::generic_category());
-        fprintf(stderr,
-                "Failed change mode because file descriptor is closed. Error message: %s",
-                _errorCode.message().c_str());
-        return _errorCode;
+    else if (!IsOpen()) {
+        _errorCode.assign(EBADF, std::generic_category());
     }
-
-    auto result = ioctl(_descriptor, _mode, _address);
-    if (result < 0) {
+    else if (ioctl(_descriptor, _mode, _address) < 0) {
         _errorCode.assign(errno, std::generic_category());
-        fprintf(stderr,
-                "Failed to acquire bus access and/or talk to slave. Error message: %s",
-                _errorCode.message().c_str());
-        return _errorCode;
     }
 
+    if (_errorCode) {
+        _lastError = _errorCode;
+    }
     return _errorCode;
 }
 
+const std::error_code& I2CDeviceImpl::LastError() const {
+    return _lastError;
+}
+
 void I2CDeviceImpl::SetCommunicationMode(uint32_t mode) {
     if (mode != _mode) {
         _mode = mode;
@@ -27,7 +27,7 @@ public:
                                           std::byte* rxBuf,
                                           size_t bytesToTransfer,
                                           size_t bytesToReceive) const;
-    [[nodiscard]] int32_t Write(std::byte* txBuf, size_t bytesToTransfer) const;
+    [[nodiscard]] int32_t Write(const std::byte* txBuf, size_t bytesToTransfer) const;
     [[nodiscard]] int32_t Read(std::byte* rxBuf, size_t bytesToReceive) const;
     [[nodiscard]] bool ReInit();
 
@@ -39,6 +39,9 @@ public:
     void SetCommunicationAddress(int32_t address);
     void SetCommunicationMode(uint32_t mode);
 
+    //! Most recent failure to select mode/address, kept until the next failure
+    [[nodiscard]] const std::error_code& LastError() const;
+
 protected:
     bool Open(uint32_t busNumber); //! Open I2C bus
     void Close();
@@ -54,6 +57,7 @@ private:
     static const uint32_t _kMaxFilenamePath{256};
     const char* _kDevicePath{"/dev/i2c-"};
     std::error_code _errorCode{};
+    std::error_code _lastError{};
 
     // Other attributes
     int32_t _descriptor{_kBadFileDescriptor};
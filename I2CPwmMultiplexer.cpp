@@ -3,7 +3,6 @@
 #include <cmath>
 #include <cstddef>
 #include <unistd.h>
-#include <iostream>
 
 #include "I2cBus.h"
 
@@ -16,7 +15,7 @@ constexpr uint8_t SUBADR1 = 0x02;
 constexpr uint8_t SUBADR2 = 0x03;
 constexpr uint8_t SUBADR3 = 0x04;
 constexpr uint8_t PRESCALE = 0xFE;
-constexpr uint8_t LED0_ON_L = 0x06;
+constexpr uint8_t LED0_ON_L = PwmPacker::kLed0OnL;
 constexpr uint8_t LED0_ON_H = 0x07;
 constexpr uint8_t LED0_OFF_L = 0x08;
 constexpr uint8_t LED0_OFF_H = 0x09;
@@ -27,6 +26,7 @@ constexpr uint8_t ALL_LED_OFF_H = 0xFD;
 
 // Bits:
 constexpr uint8_t RESTART = 0x80;
+constexpr uint8_t AI = 0x20;
 constexpr uint8_t SLEEP = 0x10;
 constexpr uint8_t ALLCALL = 0x01;
 constexpr uint8_t INVRT = 0x10;
@@ -34,13 +34,14 @@ constexpr uint8_t OUTDRV = 0x04;
 
 }// namespace
 
-I2CPwmMultiplexer::I2CPwmMultiplexer()
+I2CPwmMultiplexer::I2CPwmMultiplexer(const uint32_t busNumber, const int32_t address)
 {
-    _bus = std::make_unique<I2CBus>(1, 0x40);
+    _bus = std::make_unique<I2CBus>(busNumber, address);
 
     setAllPwm(0, 0);
     std::ignore = _bus->WriteByte(MODE2, (std::byte) OUTDRV);
-    std::ignore = _bus->WriteByte(MODE1, (std::byte) ALLCALL);
+    // Register auto-increment lets batch updates go out as a single burst
+    std::ignore = _bus->WriteByte(MODE1, (std::byte) (ALLCALL | AI));
     usleep(5'000);
     std::byte data{0};
     std::ignore = _bus->ReadByte(MODE1, &data);
@@ -57,9 +58,15 @@ bool I2CPwmMultiplexer::isInit() const
     return _bus->IsOpen();
 }
 
+std::error_code I2CPwmMultiplexer::lastError() const
+{
+    return _bus->LastError();
+}
+
 void I2CPwmMultiplexer::setPwmFreq(const double freqHz)
 {
     _frequency = freqHz;
+    _packer.setPwmFreq(freqHz);
 
     auto prescaleval = 2.5e7;//    # 25MHz
     prescaleval /= 4096.0;   //       # 12-bit
@@ -82,7 +89,6 @@ void I2CPwmMultiplexer::setPwmFreq(const double freqHz)
 
 void I2CPwmMultiplexer::setPwm(const int channel, const uint16_t on, const uint16_t off)
 {
-    std::cout << "Pwm: " << off << "\n";
     const auto channel_offset = 4 * channel;
     std::ignore = _bus->WriteByte(LED0_ON_L + channel_offset, static_cast<std::byte>(on & 0xFF));
     std::ignore = _bus->WriteByte(LED0_ON_H + channel_offset, static_cast<std::byte>(on >> 8));
@@ -105,3 +111,37 @@ void I2CPwmMultiplexer::setPwmMs(const int channel, const double ms)
     auto bits = ms * bits_per_ms;
     setPwm(channel, 0, bits);
 }
+
+bool I2CPwmMultiplexer::setPwmMsBatch(const int firstChannel, const float *ms, const size_t count)
+{
+    if (!isRunValid(firstChannel, count)) {
+        return false;
+    }
+    _packer.packMs(ms, count, &_frame[1]);
+    return writeFrame(firstChannel, count);
+}
+
+bool I2CPwmMultiplexer::setPositionBatch(const int firstChannel, const float *positions, const size_t count, const float minMs, const float maxMs)
+{
+    if (!isRunValid(firstChannel, count)) {
+        return false;
+    }
+    _packer.packPositions(positions, count, minMs, maxMs, &_frame[1]);
+    return writeFrame(firstChannel, count);
+}
+
+bool I2CPwmMultiplexer::writeBurst(const std::byte *burst, const size_t size)
+{
+    return _bus->Write(burst, size) == static_cast<int32_t>(size);
+}
+
+bool I2CPwmMultiplexer::isRunValid(const int firstChannel, const size_t count) const
+{
+    return firstChannel >= 0 && count > 0 && static_cast<size_t>(firstChannel) + count <= kChannelCount;
+}
+
+bool I2CPwmMultiplexer::writeFrame(const int firstChannel, const size_t count)
+{
+    _frame[0] = static_cast<std::byte>(LED0_ON_L + PwmPacker::kBytesPerChannel * firstChannel);
+    return writeBurst(_frame.data(), 1 + count * PwmPacker::kBytesPerChannel);
+}
@@ -1,7 +1,13 @@
 #ifndef I2CPWMMULTIPLEXER_H
 #define I2CPWMMULTIPLEXER_H
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <system_error>
+
+#include "PwmPacker.h"
 
 class I2CBus;
 
@@ -11,9 +17,19 @@ class I2CBus;
 class I2CPwmMultiplexer
 {
 public:
+    static constexpr size_t kChannelCount = 16;
+
+    /*!
+     *  @param  busNumber I2C bus the chip sits on, see PwmDiscovery
+     *  @param  address Chip address, 0x40 when no address jumpers are set
+     */
+    explicit I2CPwmMultiplexer(uint32_t busNumber = 1, int32_t address = 0x40);
     ~I2CPwmMultiplexer();
 
-    // Instance singleton
+    I2CPwmMultiplexer(const I2CPwmMultiplexer &) = delete;
+    I2CPwmMultiplexer &operator=(const I2CPwmMultiplexer &) = delete;
+
+    // Instance singleton for the default chip on bus 1
     static I2CPwmMultiplexer &instance()
     {
         static I2CPwmMultiplexer mixer;
@@ -22,6 +38,9 @@ public:
 
     [[nodiscard]] bool isInit() const;
 
+    //! Last bus error, to be reported outside the update loop
+    [[nodiscard]] std::error_code lastError() const;
+
     /*!
      *  @brief  Sets the PWM frequency for the entire chip, up to ~1.6 KHz
      *  @param  freq Floating point frequency that we will attempt to match
@@ -51,13 +70,43 @@ public:
      */
     void setPwmMs(int channel, double ms);
 
+    /*!
+     *  @brief  Sets a run of consecutive channels from pulse widths in one bus transaction
+     *  @param  firstChannel First PWM output pin of the run, from 0 to 15
+     *  @param  ms The number of Milliseconds to turn each PWM output ON
+     *  @param  count Number of channels, firstChannel + count must not exceed 16
+     *  @return true if the whole run was written
+     */
+    bool setPwmMsBatch(int firstChannel, const float *ms, size_t count);
+
+    /*!
+     *  @brief  Sets a run of consecutive channels from normalized positions in one bus transaction
+     *  @param  firstChannel First PWM output pin of the run, from 0 to 15
+     *  @param  positions Positions in range 0..1 mapped onto [minMs, maxMs]
+     *  @param  count Number of channels, firstChannel + count must not exceed 16
+     *  @return true if the whole run was written
+     */
+    bool setPositionBatch(int firstChannel, const float *positions, size_t count, float minMs, float maxMs);
+
+    /*!
+     *  @brief  Sends a prepacked register burst as is, see PwmPacker for the layout
+     *  @param  burst Start register (LEDn_ON_L) followed by 4 bytes per channel
+     *  @param  size Burst length in bytes
+     *  @return true if the whole burst was written
+     */
+    bool writeBurst(const std::byte *burst, size_t size);
+
 private:
-    I2CPwmMultiplexer();
+    [[nodiscard]] bool isRunValid(int firstChannel, size_t count) const;
+    bool writeFrame(int firstChannel, size_t count);
 
 private:
     // Default frequency pulled from PCA9685 datasheet.
     double _frequency{200.0};
     std::unique_ptr<I2CBus> _bus{nullptr};
+    PwmPacker _packer{_frequency};
+    // Start register followed by 4 bytes per channel
+    std::array<std::byte, 1 + kChannelCount * PwmPacker::kBytesPerChannel> _frame{};
 };
 
 #endif// I2CPWMMULTIPLEXER_H
@@ -60,7 +60,7 @@ std::pair<int32_t, int32_t> I2CBus::WriteRead(std::byte* txBuf,
  * @param bytesToTransfer
  * @return
  */
-int32_t I2CBus::Write(std::byte* txBuf, size_t bytesToTransfer) {
+int32_t I2CBus::Write(const std::byte* txBuf, size_t bytesToTransfer) {
     int32_t ret = -1;
     if (_pimpl && _pimpl->IsOpen()) {
         this->ChangeCommunicationAddress();
@@ -92,6 +92,14 @@ void I2CBus::ChangeCommunicationMode(uint32_t mode) {
     _pimpl->SetCommunicationMode(mode);
 }
 
+/**
+ * Last failure to select the device on the bus
+ * @return error code, empty if none happened
+ */
+std::error_code I2CBus::LastError() const {
+    return _pimpl ? _pimpl->LastError() : std::make_error_code(std::errc::bad_file_descriptor);
+}
+
 /**
  * Change communication address
  */
@@ -2,6 +2,7 @@
 #define I2C_BUS_H
 
 #include <memory>
+#include <system_error>
 
 class I2CDeviceImpl;
 
@@ -23,7 +24,7 @@ public:
                                                         std::byte* rxBuf,
                                                         size_t bytesToTransfer,
                                                         size_t bytesToReceive);
-    int32_t Write(std::byte* txBuf, size_t bytesToTransfer);
+    int32_t Write(const std::byte* txBuf, size_t bytesToTransfer);
     int32_t Read(std::byte* rxBuf, size_t bytesToTransfer);
     bool ReInit();
 
@@ -44,6 +45,7 @@ public:
     void setAddress(int32_t address) { _deviceAddress = address; }
 
     [[nodiscard]] int32_t device_address() const { return _deviceAddress; }
+    [[nodiscard]] std::error_code LastError() const;
 
 protected:
     void ChangeCommunicationAddress();
@@ -0,0 +1,343 @@
+#include "PwmDiscovery.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <future>
+#include <map>
+#include <utility>
+
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+
+namespace
+{
+// Registers and their power-on values used as the chip signature
+constexpr uint8_t MODE1 = 0x00;
+constexpr uint8_t MODE2 = 0x01;
+constexpr uint8_t SUBADR1 = 0x02;
+constexpr uint8_t SUBADR2 = 0x03;
+constexpr uint8_t SUBADR3 = 0x04;
+constexpr uint8_t ALLCALLADR = 0x05;
+constexpr uint8_t PRESCALE = 0xFE;
+
+constexpr uint8_t MODE2_RESERVED_MASK = 0xE0;
+constexpr uint8_t SUBADR1_DEFAULT = 0xE2;
+constexpr uint8_t SUBADR2_DEFAULT = 0xE4;
+constexpr uint8_t SUBADR3_DEFAULT = 0xE8;
+constexpr uint8_t ALLCALLADR_DEFAULT = 0xE0;
+constexpr uint8_t PRESCALE_MIN = 0x03;
+
+// MODE1 bits enabling the extra addresses a chip answers on
+constexpr uint8_t MODE1_ALLCALL = 0x01;
+constexpr uint8_t MODE1_SUB3 = 0x02;
+constexpr uint8_t MODE1_SUB2 = 0x04;
+constexpr uint8_t MODE1_SUB1 = 0x08;
+
+// 7-bit range without the reserved addresses, same as i2cdetect
+constexpr int32_t kFirstAddress = 0x08;
+constexpr int32_t kLastAddress = 0x77;
+// Hardware address pins A5..A0 put the chip into 0x40..0x7F
+constexpr int32_t kFirstPcaAddress = 0x40;
+
+constexpr const char *kDevicePath = "/dev/i2c-";
+
+/**
+ * Own descriptor per bus: probing needs SMBus ioctls and runs in parallel,
+ * so it does not go through the shared I2CDeviceImpl instances
+ */
+class BusHandle
+{
+public:
+    explicit BusHandle(uint32_t busNumber)
+    {
+        char devicePath[64] = {0};
+        snprintf(devicePath, sizeof(devicePath), "%s%u", kDevicePath, busNumber);
+        _descriptor = open(devicePath, O_RDWR);
+        if (_descriptor >= 0 && ioctl(_descriptor, I2C_FUNCS, &_funcs) < 0) {
+            _funcs = 0;
+        }
+    }
+
+    ~BusHandle()
+    {
+        if (_descriptor >= 0) {
+            close(_descriptor);
+        }
+    }
+
+    BusHandle(const BusHandle &) = delete;
+    BusHandle &operator=(const BusHandle &) = delete;
+
+    [[nodiscard]] bool isOpen() const { return _descriptor >= 0; }
+
+    // Fails with EBUSY when a kernel driver owns the address
+    [[nodiscard]] bool select(int32_t address) const
+    {
+        return ioctl(_descriptor, I2C_SLAVE, address) >= 0;
+    }
+
+    // Same probe choice as i2cdetect: reads where a quick write could corrupt EEPROMs
+    [[nodiscard]] bool probe(int32_t address) const
+    {
+        const bool eepromRange = (address >= 0x30 && address <= 0x37) || (address >= 0x50 && address <= 0x5F);
+        if ((eepromRange || !(_funcs & I2C_FUNC_SMBUS_QUICK)) && (_funcs & I2C_FUNC_SMBUS_READ_BYTE)) {
+            return transfer(I2C_SMBUS_READ, 0, I2C_SMBUS_BYTE, nullptr);
+        }
+        return transfer(I2C_SMBUS_WRITE, 0, I2C_SMBUS_QUICK, nullptr);
+    }
+
+    [[nodiscard]] bool readByteData(uint8_t reg, uint8_t &value) const
+    {
+        i2c_smbus_data data{};
+        if (!transfer(I2C_SMBUS_READ, reg, I2C_SMBUS_BYTE_DATA, &data)) {
+            return false;
+        }
+        value = data.byte;
+        return true;
+    }
+
+    [[nodiscard]] bool hasPcaSignature() const
+    {
+        uint8_t mode2 = 0, subadr1 = 0, subadr2 = 0, subadr3 = 0, allcall = 0, prescale = 0;
+        return readByteData(MODE2, mode2) && (mode2 & MODE2_RESERVED_MASK) == 0
+            && readByteData(SUBADR1, subadr1) && subadr1 == SUBADR1_DEFAULT
+            && readByteData(SUBADR2, subadr2) && subadr2 == SUBADR2_DEFAULT
+            && readByteData(SUBADR3, subadr3) && subadr3 == SUBADR3_DEFAULT
+            && readByteData(ALLCALLADR, allcall) && allcall == ALLCALLADR_DEFAULT
+            && readByteData(PRESCALE, prescale) && prescale >= PRESCALE_MIN;
+    }
+
+    /*!
+     * Appends the 7-bit ALLCALL and enabled SUBADRn addresses of the selected chip.
+     * Every chip answers on these too, so probing them finds a phantom copy.
+     */
+    void appendAliases(std::vector<int32_t> &aliases) const
+    {
+        uint8_t mode1 = 0;
+        if (!readByteData(MODE1, mode1)) {
+            return;
+        }
+        const std::pair<uint8_t, uint8_t> sources[] = {
+            {MODE1_ALLCALL, ALLCALLADR}, {MODE1_SUB1, SUBADR1}, {MODE1_SUB2, SUBADR2}, {MODE1_SUB3, SUBADR3}};
+        for (const auto &[bit, reg] : sources) {
+            uint8_t address = 0;
+            if ((mode1 & bit) && readByteData(reg, address)) {
+                aliases.push_back(address >> 1);
+            }
+        }
+    }
+
+private:
+    bool transfer(uint8_t readWrite, uint8_t command, uint32_t size, i2c_smbus_data *data) const
+    {
+        i2c_smbus_ioctl_data args{};
+        args.read_write = readWrite;
+        args.command = command;
+        args.size = size;
+        args.data = data;
+        return ioctl(_descriptor, I2C_SMBUS, &args) >= 0;
+    }
+
+private:
+    int _descriptor{-1};
+    unsigned long _funcs{0};
+};
+
+/**
+ * Drops addresses that are an ALLCALL/SUBADR alias of another chip in the list.
+ * A chip's own aliases are ignored: a real chip may sit at 0x70 with ALLCALL moved away.
+ */
+std::vector<int32_t> withoutAliases(const BusHandle &bus, const std::vector<int32_t> &addresses)
+{
+    std::vector<std::pair<int32_t, int32_t>> aliases;//! owner, alias
+    for (auto address : addresses) {
+        std::vector<int32_t> chipAliases;
+        if (bus.select(address)) {
+            bus.appendAliases(chipAliases);
+        }
+        for (auto alias : chipAliases) {
+            aliases.emplace_back(address, alias);
+        }
+    }
+
+    std::vector<int32_t> chips;
+    for (auto address : addresses) {
+        const bool isAlias = std::any_of(aliases.begin(), aliases.end(), [address](const auto &entry) {
+            return entry.first != address && entry.second == address;
+        });
+        if (!isAlias) {
+            chips.push_back(address);
+        }
+    }
+    return chips;
+}
+
+std::vector<PwmChipLocation> scanBus(uint32_t busNumber)
+{
+    std::vector<PwmChipLocation> chips;
+    BusHandle bus(busNumber);
+    if (!bus.isOpen()) {
+        return chips;
+    }
+    std::vector<int32_t> candidates;
+    for (auto address = kFirstAddress; address <= kLastAddress; ++address) {
+        if (!bus.select(address) || !bus.probe(address)) {
+            continue;
+        }
+        if (address >= kFirstPcaAddress && bus.hasPcaSignature()) {
+            candidates.push_back(address);
+        }
+    }
+    for (auto address : withoutAliases(bus, candidates)) {
+        chips.push_back({busNumber, address});
+    }
+    return chips;
+}
+
+bool validateBus(uint32_t busNumber, const std::vector<int32_t> &addresses)
+{
+    BusHandle bus(busNumber);
+    if (!bus.isOpen()) {
+        return false;
+    }
+    const bool signaturesMatch = std::all_of(addresses.begin(), addresses.end(), [&bus](int32_t address) {
+        return bus.select(address) && bus.hasPcaSignature();
+    });
+    // A cached broadcast alias means the topology is stale, rescan
+    return signaturesMatch && withoutAliases(bus, addresses).size() == addresses.size();
+}
+
+}// namespace
+
+PwmDiscovery::PwmDiscovery(std::string cachePath)
+    : _cachePath(std::move(cachePath))
+{
+}
+
+std::vector<PwmChipLocation> PwmDiscovery::discover(const bool forceScan)
+{
+    std::vector<PwmChipLocation> chips;
+    if (!forceScan && loadCache(chips) && !chips.empty() && validate(chips)) {
+        return chips;
+    }
+
+    chips = scan();
+    if (!saveCache(chips)) {
+        fprintf(stderr, "Failed to save pca9685 topology to %s. Error message: %s\n", _cachePath.c_str(), strerror(errno));
+    }
+    return chips;
+}
+
+std::vector<PwmChipLocation> PwmDiscovery::scan()
+{
+    std::vector<std::future<std::vector<PwmChipLocation>>> scans;
+    for (auto busNumber : listBuses()) {
+        scans.push_back(std::async(std::launch::async, scanBus, busNumber));
+    }
+
+    std::vector<PwmChipLocation> chips;
+    for (auto &busScan : scans) {
+        auto busChips = busScan.get();
+        chips.insert(chips.end(), busChips.begin(), busChips.end());
+    }
+    return chips;
+}
+
+std::vector<uint32_t> PwmDiscovery::listBuses()
+{
+    std::vector<uint32_t> buses;
+    DIR *dev = opendir("/dev");
+    if (dev == nullptr) {
+        return buses;
+    }
+    while (auto *entry = readdir(dev)) {
+        unsigned busNumber = 0;
+        char tail = 0;
+        // Exactly "i2c-<number>"
+        if (sscanf(entry->d_name, "i2c-%u%c", &busNumber, &tail) == 1) {
+            buses.push_back(busNumber);
+        }
+    }
+    closedir(dev);
+    std::sort(buses.begin(), buses.end());
+    return buses;
+}
+
+bool PwmDiscovery::isPca9685(const uint32_t busNumber, const int32_t address)
+{
+    return validateBus(busNumber, {address});
+}
+
+bool PwmDiscovery::validate(const std::vector<PwmChipLocation> &chips)
+{
+    std::map<uint32_t, std::vector<int32_t>> byBus;
+    for (const auto &chip : chips) {
+        byBus[chip.busNumber].push_back(chip.address);
+    }
+
+    std::vector<std::future<bool>> checks;
+    for (const auto &[busNumber, addresses] : byBus) {
+        checks.push_back(std::async(std::launch::async, validateBus, busNumber, addresses));
+    }
+
+    bool valid = true;
+    for (auto &check : checks) {
+        valid = check.get() && valid;
+    }
+    return valid;
+}
+
+bool PwmDiscovery::loadCache(std::vector<PwmChipLocation> &chips) const
+{
+    FILE *file = fopen(_cachePath.c_str(), "r");
+    if (file == nullptr) {
+        return false;
+    }
+
+    chips.clear();
+    bool ok = true;
+    char line[128] = {0};
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        unsigned busNumber = 0;
+        int address = 0;
+        if (sscanf(line, "%u %i", &busNumber, &address) != 2 || address < kFirstAddress || address > kLastAddress) {
+            ok = false;
+            break;
+        }
+        chips.push_back({busNumber, address});
+    }
+    fclose(file);
+    return ok;
+}
+
+bool PwmDiscovery::saveCache(const std::vector<PwmChipLocation> &chips) const
+{
+    // Write next to the cache and rename, so a crash never leaves a torn file
+    const auto tmpPath = _cachePath + ".tmp";
+    FILE *file = fopen(tmpPath.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    bool ok = fprintf(file, "# pca9685 topology: <bus> <address>\n") > 0;
+    for (const auto &chip : chips) {
+        ok = ok && fprintf(file, "%u 0x%02x\n", chip.busNumber, chip.address) > 0;
+    }
+    ok = (fclose(file) == 0) && ok;
+
+    if (!ok || rename(tmpPath.c_str(), _cachePath.c_str()) != 0) {
+        unlink(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
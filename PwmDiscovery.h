@@ -0,0 +1,63 @@
+#ifndef PWM_DISCOVERY_H
+#define PWM_DISCOVERY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Location of one pca9685 chip
+ */
+struct PwmChipLocation
+{
+    uint32_t busNumber{0};
+    int32_t address{0};
+
+    bool operator==(const PwmChipLocation &other) const
+    {
+        return busNumber == other.busNumber && address == other.address;
+    }
+};
+
+/**
+ * Finds pca9685 chips on all /dev/i2c-* buses.
+ *
+ * A full scan probes every bus in parallel (addresses are probed one by one
+ * within a bus) and identifies chips by their register signature. The result
+ * is kept in a small cache file; on the next boot only the cached entries are
+ * validated, and a full scan runs again only if one of them no longer answers.
+ * Boards added next to still-valid cached ones need discover(true).
+ */
+class PwmDiscovery
+{
+public:
+    static constexpr const char *kDefaultCachePath = "/var/tmp/pca9685-topology";
+
+    explicit PwmDiscovery(std::string cachePath = kDefaultCachePath);
+
+    /*!
+     *  @brief  Returns the chips present, validating the cache or scanning when needed
+     *  @param  forceScan Ignore the cache and probe every bus
+     *  @return chips sorted by bus and address
+     */
+    std::vector<PwmChipLocation> discover(bool forceScan = false);
+
+    //! Probes every bus in parallel without touching the cache
+    [[nodiscard]] static std::vector<PwmChipLocation> scan();
+
+    //! Bus numbers of the /dev/i2c-* nodes, sorted
+    [[nodiscard]] static std::vector<uint32_t> listBuses();
+
+    //! Checks the register signature of a single address
+    [[nodiscard]] static bool isPca9685(uint32_t busNumber, int32_t address);
+
+private:
+    [[nodiscard]] bool loadCache(std::vector<PwmChipLocation> &chips) const;
+    [[nodiscard]] bool saveCache(const std::vector<PwmChipLocation> &chips) const;
+    [[nodiscard]] static bool validate(const std::vector<PwmChipLocation> &chips);
+
+private:
+    std::string _cachePath;
+};
+
+#endif // PWM_DISCOVERY_H
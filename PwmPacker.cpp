@@ -0,0 +1,188 @@
+#include "PwmPacker.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+struct PackParams
+{
+    float scale;
+    float offset;
+    float lo;
+    float hi;
+};
+
+// NaN input ends up at lo, same as the vector max instructions
+void packScalar(const float *in, size_t count, const PackParams &p, std::byte *out)
+{
+    for (size_t i = 0; i < count; ++i) {
+        auto value = in[i] * p.scale + p.offset;
+        value = value > p.lo ? value : p.lo;
+        value = value < p.hi ? value : p.hi;
+        const auto counts = static_cast<uint16_t>(value);
+        out[0] = std::byte{0};
+        out[1] = std::byte{0};
+        out[2] = static_cast<std::byte>(counts & 0xFF);
+        out[3] = static_cast<std::byte>(counts >> 8);
+        out += PwmPacker::kBytesPerChannel;
+    }
+}
+
+// The vector kernels treat each channel as a little-endian 32-bit word:
+// ON is 0 and OFF sits in the upper half, so packing is a single shift.
+
+#if defined(__SSE2__)
+void packSse2(const float *in, size_t count, const PackParams &p, std::byte *out)
+{
+    const auto scale = _mm_set1_ps(p.scale);
+    const auto offset = _mm_set1_ps(p.offset);
+    const auto lo = _mm_set1_ps(p.lo);
+    const auto hi = _mm_set1_ps(p.hi);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto value = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(in + i), scale), offset);
+        value = _mm_min_ps(_mm_max_ps(value, lo), hi);
+        const auto words = _mm_slli_epi32(_mm_cvttps_epi32(value), 16);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i * PwmPacker::kBytesPerChannel), words);
+    }
+    packScalar(in + i, count - i, p, out + i * PwmPacker::kBytesPerChannel);
+}
+
+__attribute__((target("avx2"))) void packAvx2(const float *in, size_t count, const PackParams &p, std::byte *out)
+{
+    const auto scale = _mm256_set1_ps(p.scale);
+    const auto offset = _mm256_set1_ps(p.offset);
+    const auto lo = _mm256_set1_ps(p.lo);
+    const auto hi = _mm256_set1_ps(p.hi);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        auto value = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(in + i), scale), offset);
+        value = _mm256_min_ps(_mm256_max_ps(value, lo), hi);
+        const auto words = _mm256_slli_epi32(_mm256_cvttps_epi32(value), 16);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i * PwmPacker::kBytesPerChannel), words);
+    }
+    // Remainder stays in this function so it is VEX encoded too; handing it to the
+    // legacy SSE kernel with dirty upper YMM halves costs a state transition per call
+    for (; i + 4 <= count; i += 4) {
+        auto value = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(in + i), _mm256_castps256_ps128(scale)), _mm256_castps256_ps128(offset));
+        value = _mm_min_ps(_mm_max_ps(value, _mm256_castps256_ps128(lo)), _mm256_castps256_ps128(hi));
+        const auto words = _mm_slli_epi32(_mm_cvttps_epi32(value), 16);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i * PwmPacker::kBytesPerChannel), words);
+    }
+    _mm256_zeroupper();
+    packScalar(in + i, count - i, p, out + i * PwmPacker::kBytesPerChannel);
+}
+#endif
+
+#if defined(__aarch64__)
+void packNeon(const float *in, size_t count, const PackParams &p, std::byte *out)
+{
+    const auto scale = vdupq_n_f32(p.scale);
+    const auto offset = vdupq_n_f32(p.offset);
+    const auto lo = vdupq_n_f32(p.lo);
+    const auto hi = vdupq_n_f32(p.hi);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto value = vaddq_f32(vmulq_f32(vld1q_f32(in + i), scale), offset);
+        // maxnm returns the number when the other operand is NaN
+        value = vminq_f32(vmaxnmq_f32(value, lo), hi);
+        const auto words = vshlq_n_u32(vcvtq_u32_f32(value), 16);
+        vst1q_u8(reinterpret_cast<uint8_t *>(out + i * PwmPacker::kBytesPerChannel), vreinterpretq_u8_u32(words));
+    }
+    packScalar(in + i, count - i, p, out + i * PwmPacker::kBytesPerChannel);
+}
+#endif
+
+}// namespace
+
+PwmPacker::PwmPacker(const double freqHz, const Kernel kernel)
+    : _kernel(isSupported(kernel) ? kernel : Kernel::Scalar)
+{
+    setPwmFreq(freqHz);
+}
+
+void PwmPacker::setPwmFreq(const double freqHz)
+{
+    // Same math as I2CPwmMultiplexer::setPwmMs
+    const auto period_ms = 1000.0 / freqHz;
+    _countsPerMs = static_cast<float>(4096 / period_ms);
+}
+
+void PwmPacker::packMs(const float *ms, const size_t count, std::byte *out) const
+{
+    pack(ms, count, _countsPerMs, 0.0f, 0.0f, kMaxCounts, out);
+}
+
+void PwmPacker::packPositions(const float *positions, const size_t count, const float minMs, const float maxMs, std::byte *out) const
+{
+    const auto minCounts = minMs * _countsPerMs;
+    const auto maxCounts = maxMs * _countsPerMs;
+    const auto lo = std::clamp(std::min(minCounts, maxCounts), 0.0f, static_cast<float>(kMaxCounts));
+    const auto hi = std::clamp(std::max(minCounts, maxCounts), 0.0f, static_cast<float>(kMaxCounts));
+    pack(positions, count, maxCounts - minCounts, minCounts, lo, hi, out);
+}
+
+void PwmPacker::pack(const float *in, const size_t count, const float scale, const float offset, const float lo, const float hi, std::byte *out) const
+{
+    const PackParams params{scale, offset, lo, hi};
+    switch (_kernel) {
+#if defined(__SSE2__)
+        case Kernel::Sse2: packSse2(in, count, params, out); return;
+        case Kernel::Avx2: packAvx2(in, count, params, out); return;
+#endif
+#if defined(__aarch64__)
+        case Kernel::Neon: packNeon(in, count, params, out); return;
+#endif
+        default: packScalar(in, count, params, out); return;
+    }
+}
+
+PwmPacker::Kernel PwmPacker::bestKernel()
+{
+    static const auto best = []() {
+        for (auto kernel : {Kernel::Avx2, Kernel::Neon, Kernel::Sse2}) {
+            if (isSupported(kernel)) {
+                return kernel;
+            }
+        }
+        return Kernel::Scalar;
+    }();
+    return best;
+}
+
+bool PwmPacker::isSupported(const Kernel kernel)
+{
+    switch (kernel) {
+        case Kernel::Scalar: return true;
+#if defined(__SSE2__)
+        case Kernel::Sse2: return true;
+        case Kernel::Avx2: return __builtin_cpu_supports("avx2");
+#endif
+#if defined(__aarch64__)
+        case Kernel::Neon: return true;
+#endif
+        default: return false;
+    }
+}
+
+const char *PwmPacker::kernelName(const Kernel kernel)
+{
+    switch (kernel) {
+        case Kernel::Scalar: return "scalar";
+        case Kernel::Sse2: return "sse2";
+        case Kernel::Avx2: return "avx2";
+        case Kernel::Neon: return "neon";
+    }
+    return "unknown";
+}
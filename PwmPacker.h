@@ -0,0 +1,70 @@
+#ifndef PWMPACKER_H
+#define PWMPACKER_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Batch conversion of pulse widths into pca9685 LEDn register data.
+ *
+ * Every channel is written as 4 bytes in wire order ON_L, ON_H, OFF_L, OFF_H
+ * with ON fixed at 0, so the output can be sent as one auto-increment burst
+ * right after the LEDn_ON_L start register.
+ */
+class PwmPacker
+{
+public:
+    enum class Kernel
+    {
+        Scalar,
+        Sse2,
+        Avx2,
+        Neon
+    };
+
+    static constexpr size_t kBytesPerChannel = 4;
+    static constexpr uint8_t kLed0OnL = 0x06; //! LED0_ON_L, start register of channel 0
+    static constexpr uint16_t kMaxCounts = 4095;
+
+    explicit PwmPacker(double freqHz, Kernel kernel = bestKernel());
+
+    /*!
+     *  @brief  Updates the PWM frequency used to convert milliseconds into counts
+     *  @param  freqHz PWM frequency the chip is running at
+     */
+    void setPwmFreq(double freqHz);
+
+    /*!
+     *  @brief  Converts pulse widths, clamps them to the 12-bit range and packs them
+     *  @param  ms Pulse widths in milliseconds, one per channel
+     *  @param  count Number of channels
+     *  @param  out Destination, at least count * kBytesPerChannel bytes
+     */
+    void packMs(const float *ms, size_t count, std::byte *out) const;
+
+    /*!
+     *  @brief  Maps normalized positions onto [minMs, maxMs] and packs them
+     *  @param  positions Positions in range 0..1, values outside are clamped
+     *  @param  count Number of channels
+     *  @param  minMs Pulse width for position 0
+     *  @param  maxMs Pulse width for position 1
+     *  @param  out Destination, at least count * kBytesPerChannel bytes
+     */
+    void packPositions(const float *positions, size_t count, float minMs, float maxMs, std::byte *out) const;
+
+    [[nodiscard]] Kernel kernel() const { return _kernel; }
+
+    // Fastest kernel supported by the running CPU
+    static Kernel bestKernel();
+    static bool isSupported(Kernel kernel);
+    static const char *kernelName(Kernel kernel);
+
+private:
+    void pack(const float *in, size_t count, float scale, float offset, float lo, float hi, std::byte *out) const;
+
+private:
+    float _countsPerMs{0.0f};
+    Kernel _kernel{Kernel::Scalar};
+};
+
+#endif// PWMPACKER_H
@@ -0,0 +1,108 @@
+#include "RealTime.h"
+
+#include <cerrno>
+#include <cstdio>
+
+#include <alloca.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace
+{
+constexpr int64_t kNsPerSec = 1'000'000'000;
+}// namespace
+
+bool RealTime::enter(const Config &config)
+{
+    bool ok = true;
+
+    if (config.lockMemory) {
+        if (auto error = lockMemory()) {
+            fprintf(stderr, "Failed to lock memory. Error message: %s\n", error.message().c_str());
+            ok = false;
+        }
+    }
+
+    // After mlockall so the touched pages stay resident
+    prefaultStack(config.stackPrefault);
+
+    if (config.cpu >= 0) {
+        if (auto error = setCpuAffinity(config.cpu)) {
+            fprintf(stderr, "Failed to pin thread to cpu %d. Error message: %s\n", config.cpu, error.message().c_str());
+            ok = false;
+        }
+    }
+
+    if (config.priority > 0) {
+        if (auto error = setFifoPriority(config.priority)) {
+            fprintf(stderr, "Failed to set SCHED_FIFO priority %d. Error message: %s\n", config.priority, error.message().c_str());
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+std::error_code RealTime::lockMemory()
+{
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        return {errno, std::generic_category()};
+    }
+    // Keep freed memory in the process instead of returning it to the kernel,
+    // and serve large blocks from the locked heap rather than fresh mmaps
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+    return {};
+}
+
+void RealTime::prefaultStack(const size_t bytes)
+{
+    if (bytes == 0) {
+        return;
+    }
+    // Touch one byte per page so later stack growth does not page fault
+    auto *stack = static_cast<volatile char *>(alloca(bytes));
+    const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    for (size_t i = 0; i < bytes; i += pageSize) {
+        stack[i] = 0;
+    }
+}
+
+std::error_code RealTime::setFifoPriority(const int priority)
+{
+    sched_param param{};
+    param.sched_priority = priority;
+    if (auto result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param)) {
+        return {result, std::generic_category()};
+    }
+    return {};
+}
+
+std::error_code RealTime::setCpuAffinity(const int cpu)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (auto result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set)) {
+        return {result, std::generic_category()};
+    }
+    return {};
+}
+
+int64_t RealTime::nowNs()
+{
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * kNsPerSec + ts.tv_nsec;
+}
+
+void RealTime::sleepUntil(const int64_t ns)
+{
+    const timespec deadline{static_cast<time_t>(ns / kNsPerSec), static_cast<long>(ns % kNsPerSec)};
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR) {
+    }
+}
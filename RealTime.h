@@ -0,0 +1,45 @@
+#ifndef REALTIME_H
+#define REALTIME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+
+/**
+ * Real-time execution profile for the thread that drives the bus.
+ *
+ * Everything here is meant to be called once at startup, before the update
+ * loop begins; after that the loop must not allocate or do formatted I/O.
+ */
+class RealTime
+{
+public:
+    struct Config
+    {
+        int priority{80};               //! SCHED_FIFO priority, 0 keeps the current policy
+        int cpu{-1};                    //! CPU to pin the thread to, -1 keeps the current mask
+        size_t stackPrefault{256 * 1024};//! Bytes of stack touched up front
+        bool lockMemory{true};          //! mlockall current and future pages
+    };
+
+    RealTime() = delete;
+
+    /*!
+     *  @brief  Applies the whole profile to the calling thread, reporting failures to stderr
+     *  @return true if every requested step succeeded
+     */
+    static bool enter(const Config &config);
+
+    static std::error_code lockMemory();
+    static void prefaultStack(size_t bytes);
+    static std::error_code setFifoPriority(int priority);
+    static std::error_code setCpuAffinity(int cpu);
+
+    // CLOCK_MONOTONIC in nanoseconds, the time base for deadlines and sample stamps
+    static int64_t nowNs();
+
+    //! Sleeps until an absolute nowNs() time, resuming after signals
+    static void sleepUntil(int64_t ns);
+};
+
+#endif// REALTIME_H
@@ -0,0 +1,190 @@
+#include "SensorPoller.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "I2cBus.h"
+#include "RealTime.h"
+
+struct SensorPoller::Source
+{
+    enum class Kind
+    {
+        Burst,
+        Fifo
+    };
+
+    Source(uint32_t busNumber, int32_t address)
+        : bus(std::make_unique<I2CBus>(busNumber, address))
+    {
+    }
+
+    Kind kind{Kind::Burst};
+    std::unique_ptr<I2CBus> bus;
+    uint8_t reg{0};         //! data register or FIFO_R_W
+    uint8_t countReg{0};    //! FIFO_COUNTH, FIFO sources only
+    uint8_t length{0};      //! burst or frame length
+    int64_t periodNs{0};
+    int64_t samplePeriodNs{0};
+    int64_t nextDue{0};
+    SpscRing<SensorSample, kRingCapacity> ring;
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> errors{0};
+};
+
+SensorPoller::SensorPoller() = default;
+
+SensorPoller::~SensorPoller() = default;
+
+int SensorPoller::addBurstSource(uint32_t busNumber, int32_t address, uint8_t reg, uint8_t length, double rateHz)
+{
+    if (length == 0 || length > SensorSample::kMaxBytes) {
+        return -1;
+    }
+    auto source = std::make_unique<Source>(busNumber, address);
+    source->kind = Source::Kind::Burst;
+    source->reg = reg;
+    source->length = length;
+    return addSource(std::move(source), rateHz);
+}
+
+int SensorPoller::addFifoSource(uint32_t busNumber,
+                                int32_t address,
+                                uint8_t countReg,
+                                uint8_t dataReg,
+                                uint8_t frameLength,
+                                double rateHz,
+                                double sampleRateHz)
+{
+    if (frameLength == 0 || frameLength > SensorSample::kMaxBytes || sampleRateHz <= 0.0) {
+        return -1;
+    }
+    auto source = std::make_unique<Source>(busNumber, address);
+    source->kind = Source::Kind::Fifo;
+    source->reg = dataReg;
+    source->countReg = countReg;
+    source->length = frameLength;
+    source->samplePeriodNs = static_cast<int64_t>(1e9 / sampleRateHz);
+    return addSource(std::move(source), rateHz);
+}
+
+int SensorPoller::addSource(std::unique_ptr<Source> source, double rateHz)
+{
+    if (rateHz <= 0.0) {
+        return -1;
+    }
+    source->periodNs = static_cast<int64_t>(1e9 / rateHz);
+    source->nextDue = RealTime::nowNs();
+    _sources.push_back(std::move(source));
+    return static_cast<int>(_sources.size() - 1);
+}
+
+size_t SensorPoller::poll()
+{
+    size_t published = 0;
+    const auto now = RealTime::nowNs();
+    for (auto &source : _sources) {
+        if (now < source->nextDue) {
+            continue;
+        }
+        published += source->kind == Source::Kind::Burst ? readBurst(*source) : readFifo(*source);
+
+        source->nextDue += source->periodNs;
+        if (source->nextDue <= now) {
+            // Fell behind: skip the missed slots instead of reading back to back
+            source->nextDue = now + source->periodNs;
+        }
+    }
+    return published;
+}
+
+int64_t SensorPoller::nextDeadline() const
+{
+    auto deadline = INT64_MAX;
+    for (const auto &source : _sources) {
+        deadline = std::min(deadline, source->nextDue);
+    }
+    return deadline;
+}
+
+size_t SensorPoller::readBurst(Source &source)
+{
+    SensorSample sample;
+    // Stamp the middle of this transfer; the time poll() started would include
+    // whatever earlier sources spent on the bus
+    const auto start = RealTime::nowNs();
+    if (source.bus->ReadBytes(source.reg, source.length, sample.data.data()) != source.length) {
+        source.errors.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+    const auto done = RealTime::nowNs();
+    sample.timestampNs = start + (done - start) / 2;
+    sample.length = source.length;
+    publish(source, sample);
+    return 1;
+}
+
+size_t SensorPoller::readFifo(Source &source)
+{
+    uint16_t countBytes = 0;
+    if (source.bus->ReadWord(source.countReg, countBytes) == -1) {
+        source.errors.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+    const auto countTime = RealTime::nowNs();
+
+    // Every frame in the FIFO was acquired before the count was read, the newest
+    // one at most a sample period ago; older frames are back-dated by the output rate
+    const size_t available = countBytes / source.length;
+    const size_t framesPerBurst = kMaxBurstBytes / source.length;
+    SensorSample sample;
+    sample.length = source.length;
+
+    size_t frame = 0;
+    while (frame < available) {
+        const auto frames = std::min(framesPerBurst, available - frame);
+        const auto bytes = static_cast<uint8_t>(frames * source.length);
+        if (source.bus->ReadBytes(source.reg, bytes, _scratch.data()) != bytes) {
+            source.errors.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        for (size_t i = 0; i < frames; ++i, ++frame) {
+            const auto age = static_cast<int64_t>(available - 1 - frame);
+            sample.timestampNs = countTime - age * source.samplePeriodNs;
+            memcpy(sample.data.data(), _scratch.data() + i * source.length, source.length);
+            publish(source, sample);
+        }
+    }
+    return frame;
+}
+
+void SensorPoller::publish(Source &source, const SensorSample &sample)
+{
+    if (!source.ring.push(sample)) {
+        source.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+size_t SensorPoller::drain(int source, SensorSample *out, size_t maxCount)
+{
+    if (source < 0 || static_cast<size_t>(source) >= _sources.size()) {
+        return 0;
+    }
+    return _sources[source]->ring.popBatch(out, maxCount);
+}
+
+uint64_t SensorPoller::dropped(int source) const
+{
+    if (source < 0 || static_cast<size_t>(source) >= _sources.size()) {
+        return 0;
+    }
+    return _sources[source]->dropped.load(std::memory_order_relaxed);
+}
+
+uint64_t SensorPoller::errors(int source) const
+{
+    if (source < 0 || static_cast<size_t>(source) >= _sources.size()) {
+        return 0;
+    }
+    return _sources[source]->errors.load(std::memory_order_relaxed);
+}
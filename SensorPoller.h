@@ -0,0 +1,113 @@
+#ifndef SENSOR_POLLER_H
+#define SENSOR_POLLER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "SpscRing.h"
+
+class I2CBus;
+
+/**
+ * One burst read from a sensor, stamped with CLOCK_MONOTONIC acquisition time
+ */
+struct SensorSample
+{
+    static constexpr size_t kMaxBytes = 32;
+
+    int64_t timestampNs{0};
+    uint8_t length{0};
+    std::array<std::byte, kMaxBytes> data{};
+};
+
+/**
+ * Periodic polling of sensors sharing the bus with the pwm multiplexer.
+ *
+ * There is no polling thread: the thread that drives the bus calls poll()
+ * between pwm updates and sleeps until the earlier of its next pwm tick and
+ * nextDeadline(). Samples are published into one SPSC ring per source which a
+ * single consumer thread drains in batches.
+ *
+ * Sources are registered at startup; registering while poll() runs is not allowed.
+ */
+class SensorPoller
+{
+public:
+    static constexpr size_t kRingCapacity = 1024;
+
+    SensorPoller();
+    ~SensorPoller();
+
+    // delete copy and move
+    SensorPoller(const SensorPoller &) = delete;
+    SensorPoller(SensorPoller &&) = delete;
+    SensorPoller &operator=(const SensorPoller &) = delete;
+    SensorPoller &operator=(SensorPoller &&) = delete;
+
+    /*!
+     *  @brief  Registers a periodic burst read of consecutive data registers
+     *  @param  busNumber I2C bus the device sits on
+     *  @param  address Device address
+     *  @param  reg First register to read
+     *  @param  length Number of bytes, up to SensorSample::kMaxBytes
+     *  @param  rateHz How often to read
+     *  @return source id, or -1 if the parameters are invalid
+     */
+    int addBurstSource(uint32_t busNumber, int32_t address, uint8_t reg, uint8_t length, double rateHz);
+
+    /*!
+     *  @brief  Registers a periodic drain of a device FIFO (MPU-style FIFO_COUNTH/L + FIFO_R_W)
+     *  @param  countReg High byte of the big-endian FIFO byte count
+     *  @param  dataReg FIFO data register
+     *  @param  frameLength Bytes per FIFO frame, up to SensorSample::kMaxBytes
+     *  @param  rateHz How often to drain the FIFO
+     *  @param  sampleRateHz Device output rate, used to back-date frames read in one drain
+     *  @return source id, or -1 if the parameters are invalid
+     */
+    int addFifoSource(uint32_t busNumber,
+                      int32_t address,
+                      uint8_t countReg,
+                      uint8_t dataReg,
+                      uint8_t frameLength,
+                      double rateHz,
+                      double sampleRateHz);
+
+    /*!
+     * Bus thread. Performs every read that is due
+     * @return count of samples published
+     */
+    size_t poll();
+
+    //! Bus thread. Earliest time in CLOCK_MONOTONIC ns at which poll() has work
+    [[nodiscard]] int64_t nextDeadline() const;
+
+    /*!
+     * Consumer thread. Moves up to maxCount oldest samples of a source into out
+     * @return count of samples copied
+     */
+    size_t drain(int source, SensorSample *out, size_t maxCount);
+
+    [[nodiscard]] uint64_t dropped(int source) const;
+    [[nodiscard]] uint64_t errors(int source) const;
+
+private:
+    struct Source;
+
+    int addSource(std::unique_ptr<Source> source, double rateHz);
+    size_t readBurst(Source &source);
+    size_t readFifo(Source &source);
+    void publish(Source &source, const SensorSample &sample);
+
+private:
+    // I2CBus buffer size bounds one FIFO transfer
+    static constexpr size_t kMaxBurstBytes = 128;
+
+    std::vector<std::unique_ptr<Source>> _sources;
+    std::array<std::byte, kMaxBurstBytes> _scratch{};
+};
+
+#endif // SENSOR_POLLER_H
@@ -0,0 +1,77 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Lock-free single producer / single consumer ring buffer.
+ * Capacity must be a power of two; one thread pushes, one thread pops.
+ */
+template<typename T, size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    SpscRing() = default;
+
+    // delete copy and move
+    SpscRing(const SpscRing &) = delete;
+    SpscRing(SpscRing &&) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+    SpscRing &operator=(SpscRing &&) = delete;
+
+    /*!
+     * Producer side. Copies item into the ring
+     * @return false if the ring is full
+     */
+    bool push(const T &item)
+    {
+        const auto head = _head.load(std::memory_order_relaxed);
+        if (head - _tailCache == Capacity) {
+            _tailCache = _tail.load(std::memory_order_acquire);
+            if (head - _tailCache == Capacity) {
+                return false;
+            }
+        }
+        _items[head & kMask] = item;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*!
+     * Consumer side. Moves up to maxCount oldest items into out
+     * @return count of items copied
+     */
+    size_t popBatch(T *out, size_t maxCount)
+    {
+        const auto tail = _tail.load(std::memory_order_relaxed);
+        const auto available = _head.load(std::memory_order_acquire) - tail;
+        const auto count = available < maxCount ? available : maxCount;
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = _items[(tail + i) & kMask];
+        }
+        _tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    static constexpr size_t kMask = Capacity - 1;
+    static constexpr size_t kCacheLine = 64;
+
+    // Producer and consumer indices live on separate cache lines
+    alignas(kCacheLine) std::atomic<size_t> _head{0};
+    size_t _tailCache{0};//! producer's last seen tail
+    alignas(kCacheLine) std::atomic<size_t> _tail{0};
+    alignas(kCacheLine) T _items[Capacity]{};
+};
+
+#endif // SPSC_RING_H
@@ -1,4 +1,5 @@
 #include "I2CPwmMultiplexer.h"
+#include "PwmDiscovery.h"
 #include <iostream>
 #include <unistd.h>
 
@@ -12,7 +13,14 @@ int main(int argc, char** argv)
     int channel = atoi(argv[1]);
     int freq = atoi(argv[2]);
 
-    auto &pwm = I2CPwmMultiplexer::instance();
+    PwmDiscovery discovery;
+    const auto chips = discovery.discover();
+    if (chips.empty()) {
+        std::cerr << "No PCA9685 found!\n";
+        return 1;
+    }
+
+    I2CPwmMultiplexer pwm(chips.front().busNumber, chips.front().address);
     if (!pwm.isInit()) {
         std::cerr << "I2C not inited!\n";
         return 1;
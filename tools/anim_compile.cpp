@@ -0,0 +1,260 @@
+#include "../AnimationFormat.h"
+#include "../I2CPwmMultiplexer.h"
+#include "../PwmPacker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ * Compiles a keyframe description into an animation file for AnimationPlayer.
+ *
+ * Input, one statement per line, '#' starts a comment:
+ *   frequency <hz>                                pwm frequency, default 50
+ *   tick_ms <ms>                                  frame period, default 20
+ *   chip <bus> <address>                          address 0x40..0x77, each once; indices 0, 1, ... in order
+ *   channel <chip> <channel> <min_ms> <max_ms>    pulse widths for positions 0 and 1
+ *   key <chip> <channel> <time_ms> <position>     keyframe, position in 0..1
+ *
+ * Positions are interpolated linearly and held before the first and after the last key.
+ * Each chip drives the run from its lowest to highest animated channel; channels inside
+ * the run without keys are sent as 0 (no pulse).
+ */
+
+namespace
+{
+// Largest tick whose nanoseconds still fit AnimationHeader::tickNs
+constexpr double kMaxTickMs = std::numeric_limits<uint32_t>::max() / 1e6;
+
+struct Curve
+{
+    float minMs{1.0f};
+    float maxMs{2.0f};
+    std::vector<std::pair<double, float>> keys;//! time ms, position
+
+    [[nodiscard]] float positionAt(double timeMs) const
+    {
+        if (timeMs <= keys.front().first) {
+            return keys.front().second;
+        }
+        if (timeMs >= keys.back().first) {
+            return keys.back().second;
+        }
+        auto next = std::upper_bound(keys.begin(), keys.end(), timeMs,
+                                     [](double t, const std::pair<double, float> &key) { return t < key.first; });
+        auto prev = next - 1;
+        const auto alpha = (timeMs - prev->first) / (next->first - prev->first);
+        return static_cast<float>(prev->second + alpha * (next->second - prev->second));
+    }
+};
+
+struct Chip
+{
+    AnimationChip location{};
+    std::map<int, Curve> curves;//! by channel
+};
+
+struct Animation
+{
+    double frequency{50.0};
+    double tickMs{20.0};
+    std::vector<Chip> chips;
+    double durationMs{0.0};//! time of the last key
+    int durationLine{0};   //! line of that key, for errors about the frame count
+};
+
+bool fail(int lineNumber, const char *message)
+{
+    fprintf(stderr, "line %d: %s\n", lineNumber, message);
+    return false;
+}
+
+bool hasLeftover(std::istream &tokens)
+{
+    std::string extra;
+    return static_cast<bool>(tokens >> extra);
+}
+
+bool parse(std::istream &input, Animation &animation)
+{
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(input, line)) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+        std::istringstream tokens(line);
+        std::string keyword;
+        if (!(tokens >> keyword)) {
+            continue;
+        }
+
+        if (keyword == "frequency") {
+            if (!(tokens >> animation.frequency) || animation.frequency <= 0.0 || hasLeftover(tokens)) {
+                return fail(lineNumber, "expected frequency <hz>");
+            }
+        }
+        else if (keyword == "tick_ms") {
+            if (!(tokens >> animation.tickMs) || animation.tickMs <= 0.0 || hasLeftover(tokens)) {
+                return fail(lineNumber, "expected tick_ms <ms>");
+            }
+            if (animation.tickMs > kMaxTickMs) {
+                return fail(lineNumber, "tick_ms too large for a 32-bit nanosecond tick");
+            }
+        }
+        else if (keyword == "chip") {
+            Chip chip;
+            std::string address;
+            if (!(tokens >> chip.location.busNumber >> address) || hasLeftover(tokens)) {
+                return fail(lineNumber, "expected chip <bus> <address>");
+            }
+            char *end = nullptr;
+            chip.location.address = static_cast<int32_t>(strtol(address.c_str(), &end, 0));
+            if (*end != '\0' || chip.location.address < AnimationChip::kFirstAddress || chip.location.address > AnimationChip::kLastAddress) {
+                return fail(lineNumber, "chip address must be in 0x40..0x77");
+            }
+            const bool duplicate = std::any_of(animation.chips.begin(), animation.chips.end(), [&chip](const Chip &other) {
+                return other.location.busNumber == chip.location.busNumber && other.location.address == chip.location.address;
+            });
+            if (duplicate) {
+                return fail(lineNumber, "chip already defined");
+            }
+            animation.chips.push_back(chip);
+        }
+        else if (keyword == "channel" || keyword == "key") {
+            size_t chip = 0;
+            int channel = 0;
+            double a = 0.0, b = 0.0;
+            if (!(tokens >> chip >> channel >> a >> b) || hasLeftover(tokens)) {
+                return fail(lineNumber, "expected <chip> <channel> and two numbers");
+            }
+            if (chip >= animation.chips.size() || channel < 0 || channel >= static_cast<int>(I2CPwmMultiplexer::kChannelCount)) {
+                return fail(lineNumber, "unknown chip or channel out of range");
+            }
+            auto &curve = animation.chips[chip].curves[channel];
+            if (keyword == "channel") {
+                curve.minMs = static_cast<float>(a);
+                curve.maxMs = static_cast<float>(b);
+            }
+            else {
+                curve.keys.emplace_back(a, static_cast<float>(b));
+                if (a > animation.durationMs) {
+                    animation.durationMs = a;
+                    animation.durationLine = lineNumber;
+                }
+            }
+        }
+        else {
+            return fail(lineNumber, "unknown statement");
+        }
+    }
+    return true;
+}
+
+bool compile(Animation &animation, std::ostream &output)
+{
+    uint32_t frameSize = 0;
+    for (auto &chip : animation.chips) {
+        // Drop channels that got a range but no keys
+        for (auto it = chip.curves.begin(); it != chip.curves.end();) {
+            it = it->second.keys.empty() ? chip.curves.erase(it) : std::next(it);
+        }
+        if (chip.curves.empty()) {
+            fprintf(stderr, "chip %u 0x%02x has no keys\n", chip.location.busNumber, chip.location.address);
+            return false;
+        }
+        for (auto &[channel, curve] : chip.curves) {
+            std::stable_sort(curve.keys.begin(), curve.keys.end(),
+                             [](const auto &l, const auto &r) { return l.first < r.first; });
+        }
+        const auto channelCount = chip.curves.rbegin()->first - chip.curves.begin()->first + 1;
+        chip.location.burstOffset = frameSize;
+        chip.location.burstSize = static_cast<uint32_t>(1 + channelCount * PwmPacker::kBytesPerChannel);
+        frameSize += chip.location.burstSize;
+    }
+    if (animation.chips.empty()) {
+        fprintf(stderr, "no chips defined\n");
+        return false;
+    }
+    // Checked before the cast, converting an out of range double is undefined
+    const auto lastFrame = std::floor(animation.durationMs / animation.tickMs);
+    if (lastFrame >= std::numeric_limits<uint32_t>::max()) {
+        return fail(animation.durationLine, "key time needs more than 2^32-1 frames at this tick_ms");
+    }
+
+    AnimationHeader header{};
+    memcpy(header.magic, AnimationHeader::kMagic, sizeof(header.magic));
+    header.version = AnimationHeader::kVersion;
+    header.tickNs = static_cast<uint32_t>(std::llround(animation.tickMs * 1e6));
+    header.frameCount = static_cast<uint32_t>(lastFrame) + 1;
+    header.frameSize = frameSize;
+    header.chipCount = static_cast<uint32_t>(animation.chips.size());
+    const auto tableEnd = sizeof(AnimationHeader) + animation.chips.size() * sizeof(AnimationChip);
+    header.dataOffset = static_cast<uint32_t>((tableEnd + AnimationHeader::kDataAlignment - 1) / AnimationHeader::kDataAlignment * AnimationHeader::kDataAlignment);
+    header.pwmFrequency = static_cast<float>(animation.frequency);
+
+    output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (const auto &chip : animation.chips) {
+        output.write(reinterpret_cast<const char *>(&chip.location), sizeof(chip.location));
+    }
+    const std::vector<char> padding(header.dataOffset - tableEnd, 0);
+    output.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+
+    const PwmPacker packer(animation.frequency);
+    std::vector<std::byte> frame(frameSize);
+    std::vector<float> pulses(I2CPwmMultiplexer::kChannelCount);
+    for (uint32_t i = 0; i < header.frameCount; ++i) {
+        const auto timeMs = i * animation.tickMs;
+        for (const auto &chip : animation.chips) {
+            const auto firstChannel = chip.curves.begin()->first;
+            const auto channelCount = (chip.location.burstSize - 1) / PwmPacker::kBytesPerChannel;
+            std::fill(pulses.begin(), pulses.end(), 0.0f);
+            for (const auto &[channel, curve] : chip.curves) {
+                const auto position = std::clamp(curve.positionAt(timeMs), 0.0f, 1.0f);
+                pulses[channel - firstChannel] = curve.minMs + position * (curve.maxMs - curve.minMs);
+            }
+            auto *burst = frame.data() + chip.location.burstOffset;
+            burst[0] = static_cast<std::byte>(PwmPacker::kLed0OnL + PwmPacker::kBytesPerChannel * firstChannel);
+            packer.packMs(pulses.data(), channelCount, burst + 1);
+        }
+        output.write(reinterpret_cast<const char *>(frame.data()), frameSize);
+    }
+
+    printf("%u chips, %u frames of %u bytes, %.1f ms tick\n", header.chipCount, header.frameCount, header.frameSize, animation.tickMs);
+    return static_cast<bool>(output);
+}
+
+}// namespace
+
+int main(int argc, char **argv)
+{
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <keyframes.txt> <output.anim>\n", argv[0]);
+        return 1;
+    }
+
+    std::ifstream input(argv[1]);
+    if (!input) {
+        fprintf(stderr, "Failed to open %s\n", argv[1]);
+        return 1;
+    }
+    Animation animation;
+    if (!parse(input, animation)) {
+        return 1;
+    }
+
+    std::ofstream output(argv[2], std::ios::binary | std::ios::trunc);
+    if (!output || !compile(animation, output)) {
+        fprintf(stderr, "Failed to write %s\n", argv[2]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "../AnimationPlayer.h"
+#include "../AllocationGuard.h"
+#include "../RealTime.h"
+
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+namespace
+{
+std::atomic<bool> stopRequested{false};
+
+void onSignal(int)
+{
+    stopRequested = true;
+}
+}// namespace
+
+int main(int argc, char **argv)
+{
+    RealTime::Config rtConfig;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "p:a:h")) != -1) {
+        switch (opt) {
+            case 'p': rtConfig.priority = atoi(optarg); break;
+            case 'a': rtConfig.cpu = atoi(optarg); break;
+            default:
+                fprintf(stderr, "Usage: %s [-p priority] [-a cpu] <animation.anim>\n", argv[0]);
+                return 1;
+        }
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "Usage: %s [-p priority] [-a cpu] <animation.anim>\n", argv[0]);
+        return 1;
+    }
+
+    AnimationPlayer player(argv[optind]);
+    if (!player.isOpen()) {
+        fprintf(stderr, "Animation not ready!\n");
+        return 1;
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    if (!RealTime::enter(rtConfig)) {
+        fprintf(stderr, "Running without the full real-time profile\n");
+    }
+
+    AnimationPlayer::Stats stats;
+    {
+        AllocationGuard guard;
+        stats = player.play(&stopRequested);
+    }
+
+    printf("%u/%u frames sent, %u failed writes, %u late frames\n",
+           stats.framesSent, player.frameCount(), stats.failedWrites, stats.lateFrames);
+    if (stats.failedWrites != 0 && player.lastError()) {
+        printf("last bus error: %s\n", player.lastError().message().c_str());
+    }
+    return stats.failedWrites == 0 ? 0 : 1;
+}
@@ -0,0 +1,173 @@
+#include "../I2CPwmMultiplexer.h"
+#include "../AllocationGuard.h"
+#include "../RealTime.h"
+#include "../SensorPoller.h"
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+// I2CPwmMultiplexer::instance() sits on bus 1, sensors given with -m share it
+constexpr uint32_t kBusNumber = 1;
+// MPU-6050 style ACCEL_XOUT_H..GYRO_ZOUT_L block
+constexpr uint8_t kImuDataReg = 0x3B;
+constexpr uint8_t kImuDataLength = 14;
+
+void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [-i interval_us] [-l loops] [-n channels] [-f pwm_hz] [-p priority] [-a cpu] [-b buckets]\n"
+            "          [-m imu_address] [-r imu_hz]\n"
+            "  Drives I2CPwmMultiplexer at a fixed period and reports the update-period jitter histogram.\n"
+            "  With -m, an IMU on the same bus is polled between pwm updates by SensorPoller.\n",
+            name);
+}
+
+struct Stats
+{
+    int64_t min{INT64_MAX};
+    int64_t max{INT64_MIN};
+    int64_t sum{0};
+    int64_t count{0};
+
+    void add(int64_t value)
+    {
+        min = value < min ? value : min;
+        max = value > max ? value : max;
+        sum += value;
+        ++count;
+    }
+};
+
+}// namespace
+
+int main(int argc, char **argv)
+{
+    int64_t intervalUs = 5'000;
+    long loops = 10'000;
+    size_t channels = I2CPwmMultiplexer::kChannelCount;
+    double freq = 200.0;
+    size_t buckets = 1'000;
+    int32_t imuAddress = -1;
+    double imuRate = 1'000.0;
+    RealTime::Config rtConfig;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "i:l:n:f:p:a:b:m:r:h")) != -1) {
+        switch (opt) {
+            case 'i': intervalUs = atol(optarg); break;
+            case 'l': loops = atol(optarg); break;
+            case 'n': channels = strtoul(optarg, nullptr, 10); break;
+            case 'f': freq = atof(optarg); break;
+            case 'p': rtConfig.priority = atoi(optarg); break;
+            case 'a': rtConfig.cpu = atoi(optarg); break;
+            case 'b': buckets = strtoul(optarg, nullptr, 10); break;
+            case 'm': imuAddress = static_cast<int32_t>(strtol(optarg, nullptr, 0)); break;
+            case 'r': imuRate = atof(optarg); break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    if (intervalUs <= 0 || loops < 2 || channels == 0 || channels > I2CPwmMultiplexer::kChannelCount || buckets == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // Startup: everything that may allocate or print happens here
+    auto &pwm = I2CPwmMultiplexer::instance();
+    if (!pwm.isInit()) {
+        fprintf(stderr, "I2C not inited, measuring timer jitter without bus traffic\n");
+    }
+    pwm.setPwmFreq(freq);
+
+    SensorPoller poller;
+    int imuSource = -1;
+    if (imuAddress >= 0) {
+        imuSource = poller.addBurstSource(kBusNumber, imuAddress, kImuDataReg, kImuDataLength, imuRate);
+        if (imuSource < 0) {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    std::array<SensorSample, 64> samples{};
+    long imuSamples = 0;
+
+    std::vector<int64_t> histogram(buckets + 1, 0);// last bucket collects overflow
+    std::array<float, I2CPwmMultiplexer::kChannelCount> pulses{};
+    Stats period;
+    Stats latency;
+    long failedWrites = 0;
+
+    if (!RealTime::enter(rtConfig)) {
+        fprintf(stderr, "Running without the full real-time profile\n");
+    }
+
+    const auto intervalNs = intervalUs * 1'000;
+    {
+        AllocationGuard guard;
+
+        auto next = RealTime::nowNs();
+        int64_t previousUpdate = 0;
+        for (long i = 0; i < loops; ++i) {
+            next += intervalNs;
+
+            // Sensor reads due before the pwm tick go out on the same bus in between;
+            // without sources nextDeadline() is never earlier than the tick
+            for (auto due = poller.nextDeadline(); due < next; due = poller.nextDeadline()) {
+                RealTime::sleepUntil(due);
+                poller.poll();
+                imuSamples += static_cast<long>(poller.drain(imuSource, samples.data(), samples.size()));
+            }
+
+            RealTime::sleepUntil(next);
+            const auto wakeup = RealTime::nowNs();
+
+            // Sweep between 1 and 2 ms so every update changes the registers
+            const auto pulse = (i & 1) ? 2.0f : 1.0f;
+            for (size_t ch = 0; ch < channels; ++ch) {
+                pulses[ch] = pulse;
+            }
+            if (!pwm.setPwmMsBatch(0, pulses.data(), channels)) {
+                ++failedWrites;
+            }
+
+            const auto update = RealTime::nowNs();
+            latency.add(wakeup - next);
+            if (i > 0) {
+                const auto deviation = update - previousUpdate - intervalNs;
+                period.add(deviation);
+                const auto bucket = static_cast<size_t>((deviation < 0 ? -deviation : deviation) / 1'000);
+                ++histogram[bucket < buckets ? bucket : buckets];
+            }
+            previousUpdate = update;
+        }
+    }
+
+    printf("# interval %lld us, %ld loops, %zu channels, %ld failed writes\n",
+           static_cast<long long>(intervalUs), loops, channels, failedWrites);
+    if (imuSource >= 0) {
+        printf("# imu 0x%02x at %.0f Hz: %ld samples, %llu dropped, %llu read errors\n",
+               imuAddress, imuRate, imuSamples,
+               static_cast<unsigned long long>(poller.dropped(imuSource)),
+               static_cast<unsigned long long>(poller.errors(imuSource)));
+    }
+    if (failedWrites != 0 && pwm.lastError()) {
+        printf("# last bus error: %s\n", pwm.lastError().message().c_str());
+    }
+    printf("# wakeup latency us: min %.1f avg %.1f max %.1f\n",
+           latency.min / 1e3, latency.sum / 1e3 / latency.count, latency.max / 1e3);
+    printf("# period deviation us: min %.1f avg %.1f max %.1f\n",
+           period.min / 1e3, period.sum / 1e3 / period.count, period.max / 1e3);
+    printf("# |deviation| us  count\n");
+    for (size_t i = 0; i < buckets; ++i) {
+        if (histogram[i] != 0) {
+            printf("%06zu %lld\n", i, static_cast<long long>(histogram[i]));
+        }
+    }
+    printf("# overflows %lld\n", static_cast<long long>(histogram[buckets]));
+    return 0;
+}
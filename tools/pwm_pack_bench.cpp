@@ -0,0 +1,97 @@
+#include "../PwmPacker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+constexpr double kFrequency = 200.0;
+
+// Per-channel path as done by I2CPwmMultiplexer::setPwmMs + setPwm, minus the bus
+void packLegacy(const float *ms, size_t count, std::byte *out)
+{
+    for (size_t i = 0; i < count; ++i) {
+        auto period_ms = 1000.0 / kFrequency;
+        auto bits_per_ms = 4096 / period_ms;
+        auto bits = ms[i] * bits_per_ms;
+        const uint16_t on = 0;
+        const auto off = static_cast<uint16_t>(bits);
+        out[0] = static_cast<std::byte>(on & 0xFF);
+        out[1] = static_cast<std::byte>(on >> 8);
+        out[2] = static_cast<std::byte>(off & 0xFF);
+        out[3] = static_cast<std::byte>(off >> 8);
+        out += PwmPacker::kBytesPerChannel;
+    }
+}
+
+template<typename Fn>
+double measureNsPerChannel(Fn &&fn, size_t channels, int iterations)
+{
+    fn();// warm up
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        fn();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (double(channels) * iterations);
+}
+
+int maxCountsDiff(const std::vector<std::byte> &a, const std::vector<std::byte> &b)
+{
+    int diff = 0;
+    for (size_t i = 0; i < a.size(); i += PwmPacker::kBytesPerChannel) {
+        const auto va = std::to_integer<int>(a[i + 2]) | std::to_integer<int>(a[i + 3]) << 8;
+        const auto vb = std::to_integer<int>(b[i + 2]) | std::to_integer<int>(b[i + 3]) << 8;
+        diff = std::max(diff, std::abs(va - vb));
+    }
+    return diff;
+}
+
+void runCase(size_t channels, int iterations)
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(0.5f, 2.5f);
+    std::vector<float> ms(channels);
+    for (auto &value : ms) {
+        value = dist(rng);
+    }
+
+    std::vector<std::byte> reference(channels * PwmPacker::kBytesPerChannel);
+    std::vector<std::byte> out(reference.size());
+
+    printf("%zu channels, %d iterations\n", channels, iterations);
+    const auto legacyNs = measureNsPerChannel([&]() { packLegacy(ms.data(), channels, reference.data()); }, channels, iterations);
+    printf("%-8s %8.3f ns/channel\n", "legacy", legacyNs);
+
+    for (auto kernel : {PwmPacker::Kernel::Scalar, PwmPacker::Kernel::Sse2, PwmPacker::Kernel::Avx2, PwmPacker::Kernel::Neon}) {
+        if (!PwmPacker::isSupported(kernel)) {
+            continue;
+        }
+        PwmPacker packer(kFrequency, kernel);
+        const auto ns = measureNsPerChannel([&]() { packer.packMs(ms.data(), channels, out.data()); }, channels, iterations);
+        printf("%-8s %8.3f ns/channel  x%.1f  max diff %d counts\n",
+               PwmPacker::kernelName(kernel), ns, legacyNs / ns, maxCountsDiff(reference, out));
+    }
+}
+
+}// namespace
+
+int main(int argc, char **argv)
+{
+    if (argc > 1) {
+        runCase(std::strtoul(argv[1], nullptr, 10), argc > 2 ? std::atoi(argv[2]) : 2000);
+        return 0;
+    }
+
+    // Single-chip batches (what setPwmMsBatch packs) first, then a many-chip tick
+    for (size_t channels : {7, 8, 13, 16}) {
+        runCase(channels, 200'000);
+    }
+    runCase(4096, 2000);
+    return 0;
+}